@@ -17,6 +17,17 @@ def connect():
             print("Waiting for server...")
             time.sleep(1)
 
+def recv_response(sock):
+    # A response is one zlib stream that may span several reads.
+    decompressor = zlib.decompressobj()
+    response = b""
+    while not decompressor.eof:
+        chunk = sock.recv(65536)
+        if not chunk:
+            raise ConnectionError("connection closed")
+        response += decompressor.decompress(chunk)
+    return response.decode()
+
 def run_client(client_id):
     sock = connect()
     for _ in range(10000):
@@ -30,8 +41,7 @@ def run_client(client_id):
         try:
             compressed_cmd = zlib.compress((cmd).encode())
             sock.sendall(compressed_cmd)
-            response_compressed = sock.recv(4096)
-            response = zlib.decompress(response_compressed).decode()
+            response = recv_response(sock)
             print(f"[Client {client_id}] {response.strip()}")
         except Exception as e:
             print(f"[Client {client_id}] Reconnecting due to error: {e}")
@@ -0,0 +1,129 @@
+#include "Compression.hpp"
+#include <array>
+#include <stdexcept>
+
+Inflater::Inflater(std::size_t maxOutputSize)
+    : maxOutputSize_(maxOutputSize) {
+    if (inflateInit(&zs_) != Z_OK)
+        throw std::runtime_error("inflateInit failed");
+}
+
+Inflater::~Inflater() {
+    inflateEnd(&zs_);
+}
+
+std::size_t Inflater::feed(const char* data, std::size_t size) {
+    if (finished_) {
+        return 0;
+    }
+
+    zs_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zs_.avail_in = static_cast<uInt>(size);
+
+    std::array<char, kCompressionChunkSize> chunk;
+    for (;;) {
+        zs_.next_out = reinterpret_cast<Bytef*>(chunk.data());
+        zs_.avail_out = static_cast<uInt>(chunk.size());
+
+        int ret = inflate(&zs_, Z_NO_FLUSH);
+        if (ret == Z_STREAM_ERROR || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR || ret == Z_NEED_DICT) {
+            throw std::runtime_error("inflate failed");
+        }
+
+        std::size_t produced = chunk.size() - zs_.avail_out;
+        if (!overflowed_) {
+            if (output_.size() + produced > maxOutputSize_) {
+                overflowed_ = true;
+                std::string().swap(output_);
+            } else {
+                output_.append(chunk.data(), produced);
+            }
+        }
+
+        if (ret == Z_STREAM_END) {
+            finished_ = true;
+            break;
+        }
+        if (ret == Z_BUF_ERROR || (zs_.avail_in == 0 && zs_.avail_out != 0)) {
+            break;
+        }
+    }
+
+    return size - zs_.avail_in;
+}
+
+std::string Inflater::take() {
+    std::string out = std::move(output_);
+    reset();
+    return out;
+}
+
+void Inflater::reset() {
+    inflateReset(&zs_);
+    output_.clear();
+    finished_ = false;
+    overflowed_ = false;
+}
+
+Deflater::Deflater(int level, int windowBits, int memLevel) {
+    if (deflateInit2(&zs_, level, Z_DEFLATED, windowBits, memLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error("deflateInit failed");
+}
+
+Deflater::~Deflater() {
+    deflateEnd(&zs_);
+}
+
+void Deflater::feed(std::string_view data) {
+    zs_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs_.avail_in = static_cast<uInt>(data.size());
+    run(Z_NO_FLUSH);
+}
+
+void Deflater::finish() {
+    zs_.next_in = nullptr;
+    zs_.avail_in = 0;
+    if (run(Z_FINISH) != Z_STREAM_END) {
+        throw std::runtime_error("deflate failed");
+    }
+    deflateReset(&zs_);
+}
+
+std::string Deflater::takeOutput() {
+    std::string out = std::move(output_);
+    output_.clear();
+    return out;
+}
+
+int Deflater::run(int flush) {
+    std::array<char, kCompressionChunkSize> chunk;
+    int ret;
+    do {
+        zs_.next_out = reinterpret_cast<Bytef*>(chunk.data());
+        zs_.avail_out = static_cast<uInt>(chunk.size());
+
+        ret = deflate(&zs_, flush);
+        if (ret == Z_STREAM_ERROR) {
+            throw std::runtime_error("deflate failed");
+        }
+        output_.append(chunk.data(), chunk.size() - zs_.avail_out);
+    } while (zs_.avail_out == 0 && ret != Z_STREAM_END);
+    return ret;
+}
+
+std::string compress_string(std::string_view str) {
+    Deflater deflater;
+    deflater.feed(str);
+    deflater.finish();
+    return deflater.takeOutput();
+}
+
+std::string decompress_string(std::string_view str, std::size_t maxOutputSize) {
+    Inflater inflater(maxOutputSize);
+    inflater.feed(str.data(), str.size());
+    if (!inflater.finished())
+        throw std::runtime_error("inflate failed: truncated stream");
+    if (inflater.overflowed())
+        throw std::runtime_error("inflate failed: output too large");
+    return inflater.take();
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <zlib.h>
+
+/**
+ * @brief Size of the scratch buffer used for a single inflate/deflate step.
+ */
+constexpr std::size_t kCompressionChunkSize = 16384;
+
+class Inflater
+{
+public:
+    /**
+     * @brief Constructs an Inflater that decompresses a sequence of zlib streams.
+     *
+     * Each zlib stream fed to the inflater is treated as one message. Output beyond
+     * maxOutputSize is discarded and the message is flagged as overflowed, so an
+     * oversized (or malicious) stream never grows memory past the limit.
+     *
+     * @param maxOutputSize Maximum number of decompressed bytes kept for one message.
+     * @throws std::runtime_error If zlib initialization fails.
+     */
+    explicit Inflater(std::size_t maxOutputSize);
+
+    /**
+     * @brief Destructor for Inflater. Releases the zlib state.
+     */
+    ~Inflater();
+
+    Inflater(const Inflater &) = delete;
+    Inflater &operator=(const Inflater &) = delete;
+
+    /**
+     * @brief Feeds a chunk of compressed input into the current stream.
+     *
+     * Decompresses as much of the input as belongs to the current zlib stream and
+     * appends the result to the message buffer. Stops at the end of the stream, so
+     * bytes of the next message are left unconsumed.
+     *
+     * @param data Pointer to the compressed input.
+     * @param size Number of bytes available at data.
+     * @return The number of input bytes consumed.
+     * @throws std::runtime_error If the input is not a valid zlib stream.
+     */
+    std::size_t feed(const char *data, std::size_t size);
+
+    /**
+     * @brief Returns true once the end of the current zlib stream has been reached.
+     */
+    bool finished() const { return finished_; }
+
+    /**
+     * @brief Returns true if the current message exceeded the output limit.
+     */
+    bool overflowed() const { return overflowed_; }
+
+    /**
+     * @brief Returns the decompressed message and prepares for the next stream.
+     *
+     * @return The decompressed message, or an empty string if it overflowed.
+     */
+    std::string take();
+
+    /**
+     * @brief Discards any partial message and resets the zlib state.
+     */
+    void reset();
+
+private:
+    z_stream zs_{};
+    std::size_t maxOutputSize_;
+    std::string output_;
+    bool finished_ = false;
+    bool overflowed_ = false;
+};
+
+class Deflater
+{
+public:
+    /**
+     * @brief Constructs a Deflater that produces one zlib stream per message.
+     *
+     * The zlib state takes roughly (1 << (windowBits + 2)) + (1 << (memLevel + 9)) bytes,
+     * about 256 KB with the defaults; smaller values trade compression ratio for memory.
+     *
+     * @param level The zlib compression level.
+     * @param windowBits Base two logarithm of the history window size (9..15).
+     * @param memLevel Memory used for the internal compression state (1..9).
+     * @throws std::runtime_error If zlib initialization fails.
+     */
+    explicit Deflater(int level = Z_BEST_COMPRESSION, int windowBits = MAX_WBITS, int memLevel = 8);
+
+    /**
+     * @brief Destructor for Deflater. Releases the zlib state.
+     */
+    ~Deflater();
+
+    Deflater(const Deflater &) = delete;
+    Deflater &operator=(const Deflater &) = delete;
+
+    /**
+     * @brief Compresses a piece of the current message.
+     *
+     * Compressed bytes are appended to the pending output, which the caller drains
+     * with takeOutput() whenever it wants to write to the wire.
+     *
+     * @param data The plain bytes to compress.
+     * @throws std::runtime_error If compression fails.
+     */
+    void feed(std::string_view data);
+
+    /**
+     * @brief Terminates the current zlib stream and resets for the next message.
+     *
+     * @throws std::runtime_error If compression fails.
+     */
+    void finish();
+
+    /**
+     * @brief Returns the number of compressed bytes waiting to be taken.
+     */
+    std::size_t pending() const { return output_.size(); }
+
+    /**
+     * @brief Returns and clears the pending compressed output.
+     */
+    std::string takeOutput();
+
+private:
+    /**
+     * @brief Runs deflate with the given flush mode until no more output is produced.
+     */
+    int run(int flush);
+
+    z_stream zs_{};
+    std::string output_;
+};
+
+/**
+ * @brief Compresses a whole string into a single zlib stream.
+ *
+ * @param str The input string to be compressed.
+ * @return std::string The compressed representation of the input string.
+ * @throws std::runtime_error If compression fails.
+ */
+std::string compress_string(std::string_view str);
+
+/**
+ * @brief Decompresses a single complete zlib stream.
+ *
+ * @param str The compressed input string to decompress.
+ * @param maxOutputSize Maximum number of decompressed bytes accepted.
+ * @return std::string The decompressed output string.
+ * @throws std::runtime_error If the input is invalid, truncated or exceeds maxOutputSize.
+ */
+std::string decompress_string(std::string_view str, std::size_t maxOutputSize);
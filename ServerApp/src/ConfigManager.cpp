@@ -3,11 +3,91 @@
 #include <chrono>
 #include <iostream>
 #include <mutex>
+#include <algorithm>
+#include <cmath>
 
 using json = nlohmann::json;
 
-ConfigManager::ConfigManager(const std::string& fileName)
-    : fileName_(fileName), dirty_(false) {
+namespace {
+    /**
+     * @brief Number of keys sampled per eviction.
+     */
+    constexpr int kEvictionSamples = 10;
+
+    /**
+     * @brief LFU counter given to new keys, so they are not evicted right away.
+     */
+    constexpr std::uint32_t kLfuInitValue = 5;
+
+    /**
+     * @brief Controls how quickly the logarithmic LFU counter saturates.
+     */
+    constexpr double kLfuLogFactor = 10.0;
+
+    /**
+     * @brief Number of minutes after which an idle LFU counter is decremented by one.
+     */
+    constexpr std::uint32_t kLfuDecayMinutes = 1;
+
+    /**
+     * @brief Number of best eviction candidates kept between evictions.
+     */
+    constexpr std::size_t kEvictionPoolSize = 16;
+
+    /**
+     * @brief Bucket count below which the bucket array is never shrunk.
+     */
+    constexpr std::size_t kMinBuckets = 64;
+
+    /**
+     * @brief Returns the heap bytes owned by a string, 0 while it uses the small string buffer.
+     */
+    std::size_t heapBytes(const std::string& str) {
+        const char* object = reinterpret_cast<const char*>(&str);
+        bool inline_ = str.data() >= object && str.data() < object + sizeof(str);
+        return inline_ ? 0 : str.capacity() + 1;
+    }
+
+    std::uint32_t lfuMinutes(std::uint32_t access) {
+        return access >> 8;
+    }
+
+    /**
+     * @brief Returns the LFU counter stored in access after applying time decay.
+     */
+    std::uint32_t lfuCounter(std::uint32_t access, std::uint32_t nowMinutes) {
+        std::uint32_t counter = access & 0xFF;
+        std::uint32_t periods = ((nowMinutes - lfuMinutes(access)) & 0xFFFFFF) / kLfuDecayMinutes;
+        return periods > counter ? 0 : counter - periods;
+    }
+
+    /**
+     * @brief Increments an LFU counter with a probability that falls as it grows.
+     */
+    std::uint32_t lfuIncrement(std::uint32_t counter) {
+        if (counter == 255) {
+            return counter;
+        }
+        thread_local std::minstd_rand rng(std::random_device{}());
+        double base = counter > kLfuInitValue ? counter - kLfuInitValue : 0;
+        double probability = 1.0 / (base * kLfuLogFactor + 1.0);
+        if (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < probability) {
+            ++counter;
+        }
+        return counter;
+    }
+
+    std::uint32_t lfuAccess(std::uint32_t nowMinutes, std::uint32_t counter) {
+        return ((nowMinutes & 0xFFFFFF) << 8) | counter;
+    }
+}
+
+ConfigManager::ConfigManager(const std::string& fileName, std::size_t maxMemory, EvictionPolicy policy)
+    : fileName_(fileName), maxMemory_(maxMemory), policy_(policy),
+      startTime_(std::chrono::steady_clock::now()),
+      entries_(0, EntryMap::hasher(), EntryMap::key_equal(), EntryMap::allocator_type(&tableMemory_)),
+      samples_(SampleIndex::allocator_type(&tableMemory_)),
+      dirty_(false) {
 }
 
 ConfigManager::~ConfigManager() {
@@ -39,18 +119,33 @@ void ConfigManager::load() {
         std::cerr << "Config file not found, creating: " << fileName_ << "\n";
         {
             std::unique_lock lock(mutex_);
-            jsonData_ = nlohmann::json::object();
+            entries_.clear();
+            samples_.clear();
+            evictionPool_.clear();
+            stringMemory_ = 0;
         }
         save();
         return;
     }
 
-    std::unique_lock lock(mutex_);
+    json data = json::object();
     try {
-        file >> jsonData_;
+        file >> data;
     } catch (const std::exception& e) {
         std::cerr << "Failed to parse config: " << e.what() << "\n";
-        jsonData_ = nlohmann::json::object();
+        data = json::object();
+    }
+
+    std::unique_lock lock(mutex_);
+    entries_.clear();
+    samples_.clear();
+    evictionPool_.clear();
+    stringMemory_ = 0;
+    if (!data.is_object()) {
+        return;
+    }
+    for (const auto& [key, value] : data.items()) {
+        store(key, value.is_string() ? value.get<std::string>() : value.dump());
     }
 }
 
@@ -61,21 +156,264 @@ void ConfigManager::save() {
         std::cerr << "Unable to write config file: " << fileName_ << "\n";
         return;
     }
-    file << jsonData_.dump(4);
+    if (entries_.empty()) {
+        file << "{}";
+        return;
+    }
+
+    // Written entry by entry to avoid building a second copy of the data as one JSON tree.
+    const char* separator = "{\n";
+    for (const auto& [key, entry] : entries_) {
+        file << separator << "    " << json(key).dump() << ": " << json(entry.value).dump();
+        separator = ",\n";
+    }
+    file << "\n}";
 }
 
 std::string ConfigManager::get(const std::string& key) {
+    return find(key).value_or("");
+}
+
+std::optional<std::string> ConfigManager::find(const std::string& key) {
     std::shared_lock lock(mutex_);
-    if (jsonData_.contains(key)) {
-        return jsonData_[key];
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        touch(it->second);
+        return it->second.value;
     }
-    return "";
+    return std::nullopt;
 }
 
-void ConfigManager::set(const std::string& key, const std::string& value) {
+bool ConfigManager::set(const std::string& key, const std::string& value) {
     {
         std::unique_lock lock(mutex_);
-        jsonData_[key] = value;
+        if (!store(key, value)) {
+            return false;
+        }
     }
     dirty_ = true;
+    return true;
+}
+
+MemoryInfo ConfigManager::memoryInfo() {
+    std::shared_lock lock(mutex_);
+    return MemoryInfo{memoryUsage(), maxMemory_, entries_.size(), evictedKeys_};
+}
+
+void ConfigManager::setEvictionCallback(std::function<void(const std::string&)> callback) {
+    std::unique_lock lock(mutex_);
+    evictionCallback_ = std::move(callback);
+}
+
+std::size_t ConfigManager::nodeSize() {
+    static const std::size_t size = [] {
+        std::size_t allocated = 0;
+        EntryMap probe(16, EntryMap::hasher(), EntryMap::key_equal(), EntryMap::allocator_type(&allocated));
+        std::size_t before = allocated;
+        probe.try_emplace(std::string());
+        return allocated - before;
+    }();
+    return size;
+}
+
+std::size_t ConfigManager::memoryUsage() const {
+    return tableMemory_ + stringMemory_;
+}
+
+std::size_t ConfigManager::bucketMemory() const {
+    return tableMemory_ - entries_.size() * nodeSize() - sampleMemory();
+}
+
+std::size_t ConfigManager::sampleMemory() const {
+    return samples_.capacity() * sizeof(SampleIndex::value_type);
+}
+
+std::size_t ConfigManager::bucketMemoryFor(std::size_t bucketCount) {
+    std::size_t allocated = 0;
+    EntryMap probe(0, EntryMap::hasher(), EntryMap::key_equal(), EntryMap::allocator_type(&allocated));
+    probe.rehash(bucketCount);
+    return allocated;
+}
+
+std::size_t ConfigManager::sampleMemoryFor(std::size_t capacity) {
+    std::size_t allocated = 0;
+    SampleIndex probe{SampleIndex::allocator_type(&allocated)};
+    probe.reserve(capacity);
+    return allocated;
+}
+
+bool ConfigManager::store(const std::string& key, const std::string& value) {
+    auto it = entries_.find(key);
+    const bool inserted = it == entries_.end();
+    std::string newKey = inserted ? key : std::string();
+    std::string newValue(value);
+
+    // Grow the bucket array and samples_ explicitly, so the admission check knows their new size.
+    std::size_t bucketTarget = 0;
+    std::size_t sampleTarget = 0;
+    if (inserted) {
+        std::size_t needed = static_cast<std::size_t>(
+            std::ceil((entries_.size() + 1) / static_cast<double>(entries_.max_load_factor())));
+        if (needed > entries_.bucket_count()) {
+            bucketTarget = std::max(entries_.bucket_count() * 2, needed);
+        }
+        if (samples_.size() == samples_.capacity()) {
+            sampleTarget = std::max<std::size_t>(samples_.capacity() * 2, 1);
+        }
+    }
+
+    // Admission: the whole entry, the bucket array and samples_ after any growth must fit with
+    // every other key gone. Otherwise nothing is changed, an existing value included.
+    if (maxMemory_ != 0) {
+        std::size_t cost = nodeSize() + heapBytes(inserted ? newKey : it->first) + heapBytes(newValue) +
+                           (bucketTarget ? bucketMemoryFor(bucketTarget) : bucketMemory()) +
+                           (sampleTarget ? sampleMemoryFor(sampleTarget) : sampleMemory());
+        if (cost > maxMemory_) {
+            return false;
+        }
+    }
+
+    if (bucketTarget) {
+        entries_.rehash(bucketTarget);
+    }
+    if (sampleTarget) {
+        samples_.reserve(sampleTarget);
+    }
+
+    if (inserted) {
+        it = entries_.try_emplace(std::move(newKey)).first;
+        it->second.access.store(initialAccess(), std::memory_order_relaxed);
+        it->second.slot = static_cast<std::uint32_t>(samples_.size());
+        samples_.push_back(&*it);
+        stringMemory_ += heapBytes(it->first);
+    } else {
+        stringMemory_ -= heapBytes(it->second.value);
+        touch(it->second);
+    }
+    // The fresh copy is sized to the new value, so a shrinking overwrite releases the old buffer.
+    it->second.value.swap(newValue);
+    stringMemory_ += heapBytes(it->second.value);
+
+    evict(&it->first);
+    return true;
+}
+
+void ConfigManager::erase(EntryMap::iterator it) {
+    std::uint32_t slot = it->second.slot;
+    samples_[slot] = samples_.back();
+    samples_[slot]->second.slot = slot;
+    samples_.pop_back();
+    stringMemory_ -= heapBytes(it->first) + heapBytes(it->second.value);
+    entries_.erase(it);
+}
+
+void ConfigManager::evict(const std::string* keep) {
+    if (maxMemory_ == 0) {
+        return;
+    }
+
+    while (memoryUsage() > maxMemory_ && entries_.size() > (keep ? 1u : 0u)) {
+        for (int i = 0; i < kEvictionSamples; ++i) {
+            const auto* node = samples_[evictionRng_() % samples_.size()];
+            if (keep && node->first == *keep) {
+                continue;
+            }
+            bool pooled = false;
+            for (const auto& candidate : evictionPool_) {
+                if (candidate.key == node->first) {
+                    pooled = true;
+                    break;
+                }
+            }
+            if (!pooled) {
+                addEvictionCandidate({evictionScore(node->second), node->first});
+            }
+        }
+
+        while (!evictionPool_.empty()) {
+            EvictionCandidate candidate = std::move(evictionPool_.front());
+            evictionPool_.erase(evictionPool_.begin());
+
+            auto it = entries_.find(candidate.key);
+            if (it == entries_.end() || (keep && candidate.key == *keep)) {
+                continue;
+            }
+            // The key may have been read since it was pooled; requeue it if it is no longer the best.
+            std::uint64_t score = evictionScore(it->second);
+            if (score < candidate.score && !evictionPool_.empty() && score < evictionPool_.front().score) {
+                candidate.score = score;
+                addEvictionCandidate(std::move(candidate));
+                continue;
+            }
+            if (evictionCallback_) {
+                evictionCallback_(it->first);
+            }
+            erase(it);
+            ++evictedKeys_;
+            break;
+        }
+
+        shrinkIfSparse();
+    }
+}
+
+void ConfigManager::addEvictionCandidate(EvictionCandidate candidate) {
+    auto pos = std::find_if(evictionPool_.begin(), evictionPool_.end(), [&](const EvictionCandidate& other) {
+        return other.score < candidate.score;
+    });
+    if (pos == evictionPool_.end() && evictionPool_.size() >= kEvictionPoolSize) {
+        return;
+    }
+    evictionPool_.insert(pos, std::move(candidate));
+    if (evictionPool_.size() > kEvictionPoolSize) {
+        evictionPool_.pop_back();
+    }
+}
+
+void ConfigManager::shrinkIfSparse() {
+    if (entries_.bucket_count() > kMinBuckets &&
+        entries_.size() < entries_.bucket_count() * entries_.max_load_factor() / 4) {
+        entries_.rehash(0);
+    }
+    if (samples_.capacity() > kMinBuckets && samples_.size() < samples_.capacity() / 4) {
+        samples_.shrink_to_fit();
+    }
+}
+
+std::uint32_t ConfigManager::initialAccess() const {
+    if (policy_ == EvictionPolicy::Lfu) {
+        return lfuAccess(clockMinutes(), kLfuInitValue);
+    }
+    return clockMs();
+}
+
+void ConfigManager::touch(Entry& entry) const {
+    if (policy_ == EvictionPolicy::Lfu) {
+        std::uint32_t nowMinutes = clockMinutes();
+        std::uint32_t counter = lfuCounter(entry.access.load(std::memory_order_relaxed), nowMinutes);
+        entry.access.store(lfuAccess(nowMinutes, lfuIncrement(counter)), std::memory_order_relaxed);
+    } else {
+        entry.access.store(clockMs(), std::memory_order_relaxed);
+    }
+}
+
+std::uint64_t ConfigManager::evictionScore(const Entry& entry) const {
+    std::uint32_t access = entry.access.load(std::memory_order_relaxed);
+    if (policy_ == EvictionPolicy::Lfu) {
+        return 255 - lfuCounter(access, clockMinutes());
+    }
+    return static_cast<std::uint32_t>(clockMs() - access);
+}
+
+std::uint64_t ConfigManager::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime_).count();
+}
+
+std::uint32_t ConfigManager::clockMs() const {
+    return static_cast<std::uint32_t>(elapsedMs());
+}
+
+std::uint32_t ConfigManager::clockMinutes() const {
+    return static_cast<std::uint32_t>(elapsedMs() / 60000);
 }
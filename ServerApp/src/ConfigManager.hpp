@@ -1,11 +1,29 @@
 #pragma once
 
+#include "CountingAllocator.hpp"
+#include "MemoryInfo.hpp"
+
 #include <string>
 #include <unordered_map>
 #include <shared_mutex>
 #include <nlohmann/json.hpp>
 #include <atomic>
 #include <thread>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <optional>
+#include <functional>
+
+/**
+ * @brief Policy used to choose which key to evict once maxmemory is reached.
+ */
+enum class EvictionPolicy
+{
+    Lru, ///< Evict the least recently used key among the sampled ones.
+    Lfu  ///< Evict the least frequently used key among the sampled ones.
+};
 
 class ConfigManager
 {
@@ -16,8 +34,10 @@ public:
      * This constructor sets the configuration filename and initializes the dirty flag to false.
      *
      * @param fileName The path to the configuration file to be managed.
+     * @param maxMemory The memory limit in bytes for stored entries, or 0 for no limit.
+     * @param policy The eviction policy applied when maxMemory is exceeded.
      */
-    ConfigManager(const std::string &fileName);
+    ConfigManager(const std::string &fileName, std::size_t maxMemory = 0, EvictionPolicy policy = EvictionPolicy::Lru);
 
     /**
      * @brief Destructor for ConfigManager.
@@ -48,10 +68,11 @@ public:
      *
      * Attempts to open and parse the configuration file as JSON. If the file does not exist,
      * it creates a new empty JSON object and saves it to the file. If the file exists but
-     * cannot be parsed, it logs an error and falls back to an empty JSON object.
+     * cannot be parsed, it logs an error and falls back to an empty configuration.
+     * If the loaded data exceeds maxMemory, keys are evicted until it fits.
      *
      * Thread safety is ensured by acquiring a unique lock on mutex_ during modifications
-     * to the internal JSON data.
+     * to the stored entries.
      *
      * @note This function will create the configuration file if it does not exist.
      */
@@ -72,37 +93,206 @@ public:
      * @brief Retrieves the value associated with the specified key from the configuration.
      *
      * Acquires a shared lock to ensure thread-safe access to the configuration data.
-     * If the key exists in the internal JSON data, returns its corresponding value as a string.
-     * If the key does not exist, returns an empty string.
+     * If the key exists, returns its corresponding value as a string and records the access
+     * in the entry's own metadata; no shared structure is modified, so reads stay concurrent.
+     * If the key does not exist (or was evicted), returns an empty string.
      *
      * @param key The configuration key to look up.
      * @return The value associated with the key, or an empty string if the key is not found.
      */
     std::string get(const std::string &key);
 
+    /**
+     * @brief Retrieves the value for a key, telling a missing key apart from an empty value.
+     *
+     * Behaves like get(), including recording the access.
+     *
+     * @param key The configuration key to look up.
+     * @return The value associated with the key, or std::nullopt if the key is not stored.
+     */
+    std::optional<std::string> find(const std::string &key);
+
     /**
      * @brief Sets the value for a given configuration key.
      *
-     * Updates the internal JSON data with the specified key-value pair.
+     * Updates the stored entries with the specified key-value pair.
      * Marks the configuration as dirty to indicate that changes have been made.
+     * If maxMemory is set and exceeded afterwards, other keys are evicted according to
+     * the eviction policy.
      * Thread-safe: acquires a lock to ensure safe concurrent access.
      *
      * @param key The configuration key to set.
      * @param value The value to associate with the key.
+     * @return false if the entry does not fit into maxMemory even with every other key evicted;
+     *         nothing is stored and nothing is evicted then.
      */
-    void set(const std::string &key, const std::string &value);
+    bool set(const std::string &key, const std::string &value);
+
+    /**
+     * @brief Returns the current memory figures.
+     *
+     * usedMemory counts the hash table nodes, the bucket array and the eviction sample index
+     * with the sizes requested from the allocator, plus the heap buffers of keys and values.
+     * Bookkeeping inside the allocator itself is not included.
+     *
+     * @return A snapshot of used memory, the limit, the key count and the number of evictions.
+     */
+    MemoryInfo memoryInfo();
+
+    /**
+     * @brief Sets the function called with every key removed by eviction.
+     *
+     * The callback runs under the unique lock and must not call back into ConfigManager.
+     * Must be called before the store is used concurrently.
+     *
+     * @param callback Function receiving the evicted key.
+     */
+    void setEvictionCallback(std::function<void(const std::string &)> callback);
 
 private:
+    /**
+     * @brief A stored value with its compact eviction metadata.
+     *
+     * access holds the last access time in milliseconds for LRU, or the last decay time in
+     * minutes (upper 24 bits) and a logarithmic access counter (lower 8 bits) for LFU.
+     * It is updated atomically under the shared lock, so reads never take the unique lock.
+     * slot is the entry's position in samples_.
+     */
+    struct Entry
+    {
+        std::string value;
+        std::atomic<std::uint32_t> access{0};
+        std::uint32_t slot = 0;
+    };
+
+    using EntryMap = std::unordered_map<std::string, Entry, std::hash<std::string>, std::equal_to<std::string>,
+                                        CountingAllocator<std::pair<const std::string, Entry>>>;
+    using SampleIndex = std::vector<EntryMap::value_type *, CountingAllocator<EntryMap::value_type *>>;
+
+    /**
+     * @brief A key sampled for eviction together with its eviction score.
+     */
+    struct EvictionCandidate
+    {
+        std::uint64_t score;
+        std::string key;
+    };
+
+    /**
+     * @brief Returns the size of one hash table node, measured once with a probe map.
+     */
+    static std::size_t nodeSize();
+
+    /**
+     * @brief Returns the memory used by entries, the bucket array and samples_. Requires mutex_.
+     */
+    std::size_t memoryUsage() const;
+
+    /**
+     * @brief Returns the memory used by the bucket array alone. Requires mutex_.
+     */
+    std::size_t bucketMemory() const;
+
+    /**
+     * @brief Returns the memory used by samples_. Requires mutex_.
+     */
+    std::size_t sampleMemory() const;
+
+    /**
+     * @brief Returns the memory a bucket array of the given requested size takes, measured with a probe map.
+     */
+    static std::size_t bucketMemoryFor(std::size_t bucketCount);
+
+    /**
+     * @brief Returns the memory samples_ takes with the given requested capacity, measured with a probe.
+     */
+    static std::size_t sampleMemoryFor(std::size_t capacity);
+
+    /**
+     * @brief Stores a key-value pair, evicting other keys if needed. Requires a unique lock.
+     *
+     * The full cost of the entry, including any growth of the bucket array and samples_, is
+     * checked before anything is changed.
+     *
+     * @return false if the entry cannot fit into maxMemory_ on its own; nothing is changed then.
+     */
+    bool store(const std::string &key, const std::string &value);
+
+    /**
+     * @brief Removes an entry and updates samples_ and the memory accounting. Requires a unique lock.
+     */
+    void erase(EntryMap::iterator it);
+
+    /**
+     * @brief Evicts keys until memory usage fits into maxMemory_. Requires a unique lock.
+     *
+     * Every round samples kEvictionSamples entries uniformly from samples_ into a small pool of
+     * the best candidates seen so far, which is kept across calls, and evicts the best of them.
+     *
+     * @param keep A key that must not be evicted (the one just written), or nullptr.
+     */
+    void evict(const std::string *keep);
+
+    /**
+     * @brief Adds a candidate to evictionPool_, keeping it sorted and bounded. Requires a unique lock.
+     */
+    void addEvictionCandidate(EvictionCandidate candidate);
+
+    /**
+     * @brief Shrinks the bucket array and samples_ once they are mostly empty. Requires a unique lock.
+     */
+    void shrinkIfSparse();
+
+    /**
+     * @brief Returns the metadata value for a newly stored entry.
+     */
+    std::uint32_t initialAccess() const;
+
+    /**
+     * @brief Records an access to the entry according to the eviction policy.
+     */
+    void touch(Entry &entry) const;
+
+    /**
+     * @brief Returns an eviction score; the sampled entry with the highest score is evicted.
+     */
+    std::uint64_t evictionScore(const Entry &entry) const;
+
+    /**
+     * @brief Returns milliseconds elapsed since construction.
+     */
+    std::uint64_t elapsedMs() const;
+
+    /**
+     * @brief Returns milliseconds elapsed since construction, truncated to 32 bits.
+     */
+    std::uint32_t clockMs() const;
+
+    /**
+     * @brief Returns minutes elapsed since construction, truncated to 32 bits.
+     */
+    std::uint32_t clockMinutes() const;
+
     std::string fileName_;
+    std::size_t maxMemory_;
+    EvictionPolicy policy_;
+    std::chrono::steady_clock::time_point startTime_;
     
     /**
-     * @brief Mutex to protect access to jsonData_.
+     * @brief Mutex to protect access to entries_.
      *
-     * Ensures thread-safe operations on the jsonData_ member variable.
+     * Ensures thread-safe operations on the entries_ member variable.
      * Allows multiple readers or one writer at a time.
      */
     std::shared_mutex mutex_;
-    nlohmann::json jsonData_;
+    std::size_t tableMemory_ = 0;  // bytes allocated by entries_ and samples_
+    std::size_t stringMemory_ = 0; // heap buffers of stored keys and values
+    EntryMap entries_;
+    SampleIndex samples_;
+    std::vector<EvictionCandidate> evictionPool_;
+    std::size_t evictedKeys_ = 0;
+    std::function<void(const std::string &)> evictionCallback_;
+    std::minstd_rand evictionRng_;
     std::atomic<bool> dirty_;
     std::atomic<bool> stopRequested_ = false;
     std::thread backgroundThread_;
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief Allocator that adds every allocation to an external byte counter.
+ *
+ * Used by containers whose memory must be accounted exactly: nodes and bucket arrays are
+ * counted with the sizes the standard library actually requests, whatever its layout.
+ * Allocator bookkeeping inside malloc itself is not included. The counter is not
+ * synchronized; the owner must serialize all allocating operations.
+ *
+ * @tparam T The allocated value type.
+ */
+template <typename T>
+class CountingAllocator
+{
+public:
+    using value_type = T;
+
+    /**
+     * @brief Constructs an allocator that reports to the given counter.
+     *
+     * @param counter Byte counter to update; must outlive every container using it.
+     */
+    explicit CountingAllocator(std::size_t *counter) noexcept : counter_(counter) {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &other) noexcept : counter_(other.counter()) {}
+
+    T *allocate(std::size_t n)
+    {
+        T *p = std::allocator<T>().allocate(n);
+        *counter_ += n * sizeof(T);
+        return p;
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+        std::allocator<T>().deallocate(p, n);
+        *counter_ -= n * sizeof(T);
+    }
+
+    std::size_t *counter() const noexcept { return counter_; }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U> &other) const noexcept { return counter_ == other.counter(); }
+
+private:
+    std::size_t *counter_;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Snapshot of the memory figures tracked by ConfigManager.
+ */
+struct MemoryInfo
+{
+    std::size_t usedMemory;  ///< Bytes accounted for all entries and the hash table.
+    std::size_t maxMemory;   ///< Configured limit in bytes, 0 if unlimited.
+    std::size_t keys;        ///< Number of stored keys.
+    std::size_t evictedKeys; ///< Number of keys evicted since construction.
+};
@@ -8,7 +8,8 @@
 #include <boost/asio/buffer.hpp>
 #include <iostream>
 #include <format>
-#include <zlib.h>
+#include <optional>
+#include <vector>
 
 using boost::asio::co_spawn;
 using boost::asio::detached;
@@ -21,89 +22,64 @@ namespace this_coro = boost::asio::this_coro;
 
 namespace {
     /**
-     * @brief Compresses a given string using the zlib deflate algorithm.
-     *
-     * This function takes an input string and compresses it using the zlib library
-     * with the best compression level. The compressed data is returned as a std::string.
-     *
-     * @param str The input string to be compressed.
-     * @return std::string The compressed representation of the input string.
-     *
-     * @throws std::runtime_error If compression initialization or processing fails.
+     * @brief Extra room in a decompressed request for the command prefix and key.
      */
-    std::string compress_string(const std::string& str) {
-        z_stream zs{};
-        if (deflateInit(&zs, Z_BEST_COMPRESSION) != Z_OK)
-            throw std::runtime_error("deflateInit failed");
-
-        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str.data()));
-        zs.avail_in = static_cast<uInt>(str.size());
-
-        std::string outstring;
-        std::vector<char> outbuffer(32768);
-
-        int ret;
-        do {
-            zs.next_out = reinterpret_cast<Bytef*>(outbuffer.data());
-            zs.avail_out = static_cast<uInt>(outbuffer.size());
-
-            ret = deflate(&zs, Z_FINISH);
-            if (ret == Z_STREAM_ERROR) {
-                deflateEnd(&zs);
-                throw std::runtime_error("deflate failed");
-            }
-            outstring.append(outbuffer.data(), outbuffer.size() - zs.avail_out);
-        } while (ret != Z_STREAM_END);
+    constexpr std::size_t kCommandOverhead = 4096;
 
-        deflateEnd(&zs);
-        return outstring;
-    }
+    constexpr std::string_view kValueTooLarge = "Value too large\n";
+
+    /**
+     * @brief zlib window and memory level for responses.
+     *
+     * Together about 24 KB of deflate state instead of the 256 KB zlib default. The state
+     * only lives while a response is being sent, so idle sessions hold no deflate memory.
+     */
+    constexpr int kResponseWindowBits = 12;
+    constexpr int kResponseMemLevel = 4;
 
     /**
-     * @brief Decompresses a string using the zlib inflate algorithm.
+     * @brief Compresses a response and writes it to the socket in bounded chunks.
      *
-     * This function takes a compressed input string (in zlib format) and decompresses it,
-     * returning the resulting uncompressed string. It throws a std::runtime_error if
-     * decompression fails at any stage.
+     * The response is passed as a list of pieces so that large values are never
+     * concatenated into one plain string. Each piece is fed to the deflater in
+     * slices of kCompressionChunkSize, and compressed output is written as soon as
+     * a full chunk is pending, so neither the plain nor the compressed response is
+     * held in memory as a whole. A compact deflater is created per response, so one
+     * zlib stream is produced per response and idle sessions hold no deflate state.
      *
-     * @param str The compressed input string to decompress.
-     * @return std::string The decompressed output string.
-     * @throws std::runtime_error If initialization or decompression fails.
+     * @param socket The client socket to write to.
+     * @param parts The plain response pieces, in order.
+     * @return awaitable<void> Coroutine handle for asynchronous execution.
+     * @throws std::runtime_error If compression fails.
      */
-    std::string decompress_string(const std::string& str) {
-        z_stream zs{};
-        if (inflateInit(&zs) != Z_OK)
-            throw std::runtime_error("inflateInit failed");
-
-        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str.data()));
-        zs.avail_in = static_cast<uInt>(str.size());
-
-        std::string outstring;
-        std::vector<char> outbuffer(32768);
-
-        int ret;
-        do {
-            zs.next_out = reinterpret_cast<Bytef*>(outbuffer.data());
-            zs.avail_out = static_cast<uInt>(outbuffer.size());
-
-            ret = inflate(&zs, 0);
-            if (ret == Z_STREAM_ERROR || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR) {
-                inflateEnd(&zs);
-                throw std::runtime_error("inflate failed");
+    awaitable<void> sendResponse(tcp::socket& socket, const std::vector<std::string_view>& parts) {
+        Deflater deflater(Z_BEST_COMPRESSION, kResponseWindowBits, kResponseMemLevel);
+        for (std::string_view part : parts) {
+            while (!part.empty()) {
+                std::string_view slice = part.substr(0, kCompressionChunkSize);
+                part.remove_prefix(slice.size());
+                deflater.feed(slice);
+                if (deflater.pending() >= kCompressionChunkSize) {
+                    std::string out = deflater.takeOutput();
+                    co_await boost::asio::async_write(socket, buffer(out), use_awaitable);
+                }
             }
-            outstring.append(outbuffer.data(), outbuffer.size() - zs.avail_out);
-        } while (ret != Z_STREAM_END);
-
-        inflateEnd(&zs);
-        return outstring;
+        }
+        deflater.finish();
+        std::string out = deflater.takeOutput();
+        co_await boost::asio::async_write(socket, buffer(out), use_awaitable);
     }
 }
 
-Server::Server(boost::asio::io_context& io_context, short port)
-    : acceptor_(boost::asio::make_strand(io_context), tcp::endpoint(tcp::v4(), port)),
-      configManager_("config.txt"),
+Server::Server(boost::asio::io_context& io_context, short port, const ServerOptions& options)
+    : ioContext_(io_context),
+      acceptor_(boost::asio::make_strand(io_context), tcp::endpoint(tcp::v4(), port)),
+      maxValueSize_(options.maxValueSize),
+      configManager_(options.configFile, options.maxMemory, options.policy),
       stats_() {
+    configManager_.setEvictionCallback([this](const std::string& key) { stats_.removeKey(key); });
     configManager_.load();
+    stats_.setMemorySource([this]() { return configManager_.memoryInfo(); });
     stats_.start();
 }
 
@@ -118,11 +94,17 @@ void Server::run() {
     co_spawn(acceptor_.get_executor(), listener(), detached);
 }
 
+unsigned short Server::port() const {
+    return acceptor_.local_endpoint().port();
+}
+
 awaitable<void> Server::listener() {
     try {
         for (;;) {
-            tcp::socket socket = co_await acceptor_.async_accept(use_awaitable);
-            co_spawn(acceptor_.get_executor(), handleClient(std::move(socket)), detached);
+            // Each session gets its own strand so clients are served in parallel.
+            tcp::socket socket = co_await acceptor_.async_accept(boost::asio::make_strand(ioContext_), use_awaitable);
+            auto executor = socket.get_executor();
+            co_spawn(executor, handleClient(std::move(socket)), detached);
         }
     } catch (const std::exception& e) {
         std::cerr << "Listener exception: " << e.what() << std::endl;
@@ -133,60 +115,44 @@ awaitable<void> Server::listener() {
 awaitable<void> Server::handleClient(tcp::socket socket) {
     std::cout << "[Info] Client connected\n";
     try {
-        auto executor = co_await this_coro::executor;
-        std::array<char, 4096> data;
-        
-        for (;;) {
+        // Large responses go out in several writes; without TCP_NODELAY the last one waits
+        // for the client's delayed ACK (Nagle), adding tens of milliseconds per response.
+        socket.set_option(tcp::no_delay(true));
+        Inflater inflater(maxValueSize_ + kCommandOverhead);
+        const std::vector<std::string_view> tooLarge{kValueTooLarge};
+        std::array<char, kCompressionChunkSize> data;
+        bool corrupted = false;
+
+        while (!corrupted) {
             std::size_t n = co_await socket.async_read_some(buffer(data), use_awaitable);
             if (n == 0) {
                 break;
             }
 
-            std::string compressed_input(data.data(), n);
-            std::string line;
-            try {
-                line = decompress_string(compressed_input);
-            } catch (const std::exception& e) {
-                std::cerr << "Decompression error: " << e.what() << "\n";
-                continue;
-            }
+            std::size_t offset = 0;
+            while (offset < n) {
+                try {
+                    offset += inflater.feed(data.data() + offset, n - offset);
+                } catch (const std::exception& e) {
+                    // Commands are delimited only by the end of their zlib stream, so after
+                    // corrupt input there is no way to find the next one: close the session.
+                    std::cerr << "Decompression error: " << e.what() << ", closing connection\n";
+                    corrupted = true;
+                    break;
+                }
 
-            if (line.empty()) continue;
+                if (!inflater.finished()) {
+                    break;
+                }
 
-            std::string response;
-            if (line.starts_with("$get ")) {
-                auto key = line.substr(5);
-                //key.erase(key.find_last_not_of(" \r\n") + 1);
-                std::string value = configManager_.get(key);
-                stats_.incrementGet(key);
-                auto [reads, writes] = stats_.getStats(key);
-                response = std::format("{}={}\nreads={}\nwrites={}\n", key, value, reads, writes);
-            } else if (line.starts_with("$set ")) {
-                auto eq = line.find('=');
-                if (eq != std::string::npos && eq > 5) {
-                    std::string key = line.substr(5, eq - 5);
-                    std::string value = line.substr(eq + 1);
-                    //value.erase(value.find_last_not_of(" \r\n") + 1);
-                    configManager_.set(key, value);
-                    stats_.incrementSet(key);
-                    auto [reads, writes] = stats_.getStats(key);
-                    response = std::format("Set {}={}\nreads={}\nwrites={}\n", key, value, reads, writes);
-                } else {
-                    response = "Invalid $set format\n";
+                if (inflater.overflowed()) {
+                    inflater.reset();
+                    co_await sendResponse(socket, tooLarge);
+                    continue;
                 }
-            } else {
-                response = "Unknown command\n";
-            }
 
-            std::string compressed;
-            try {
-                compressed = compress_string(response);
-            } catch (const std::exception& e) {
-                std::cerr << "Compression error: " << e.what() << std::endl;
-                compressed = "Compression failed\n";
+                co_await processCommand(socket, inflater.take());
             }
-
-            co_await boost::asio::async_write(socket, boost::asio::buffer(compressed), use_awaitable);
         }
     } catch (const boost::system::system_error& e) {
         if (e.code() == boost::asio::error::eof) {
@@ -194,6 +160,50 @@ awaitable<void> Server::handleClient(tcp::socket socket) {
         } else {
             std::cerr << "Client session exception: " << e.what() << "\n";
         }
+    } catch (const std::exception& e) {
+        std::cerr << "Client session exception: " << e.what() << "\n";
     }
     co_return;
 }
+
+awaitable<void> Server::processCommand(tcp::socket& socket, std::string line) {
+    std::string key;
+    std::string value;
+    std::string counters;
+    std::vector<std::string_view> response;
+
+    if (line.starts_with("$get ")) {
+        key = line.substr(5);
+        //key.erase(key.find_last_not_of(" \r\n") + 1);
+        std::optional<std::string> found = configManager_.find(key);
+        stats_.incrementGet(key, found.has_value());
+        value = std::move(found).value_or("");
+        auto [reads, writes] = stats_.getStats(key);
+        counters = std::format("\nreads={}\nwrites={}\n", reads, writes);
+        response = {key, "=", value, counters};
+    } else if (line.starts_with("$set ")) {
+        auto eq = line.find('=');
+        if (eq != std::string::npos && eq > 5) {
+            key = line.substr(5, eq - 5);
+            line.erase(0, eq + 1);
+            value = std::move(line);
+            //value.erase(value.find_last_not_of(" \r\n") + 1);
+            if (value.size() > maxValueSize_) {
+                response = {kValueTooLarge};
+            } else if (!configManager_.set(key, value)) {
+                response = {"Out of memory\n"};
+            } else {
+                stats_.incrementSet(key);
+                auto [reads, writes] = stats_.getStats(key);
+                counters = std::format("\nreads={}\nwrites={}\n", reads, writes);
+                response = {"Set ", key, "=", value, counters};
+            }
+        } else {
+            response = {"Invalid $set format\n"};
+        }
+    } else {
+        response = {"Unknown command\n"};
+    }
+
+    co_await sendResponse(socket, response);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Compression.hpp"
 #include "ConfigManager.hpp"
 #include "Stats.hpp"
 
@@ -8,18 +9,38 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/use_awaitable.hpp>
 
+/**
+ * @brief Settings a Server is constructed with.
+ */
+struct ServerOptions {
+    /// Path of the JSON file the configuration is loaded from and saved to.
+    std::string configFile = "config.txt";
+
+    /// The largest value, in bytes, accepted by "$set". Larger requests are drained
+    /// without being buffered and answered with "Value too large".
+    std::size_t maxValueSize = 1024 * 1024;
+
+    /// The memory limit in bytes for stored entries, or 0 for no limit.
+    std::size_t maxMemory = 0;
+
+    /// The eviction policy applied when maxMemory is exceeded.
+    EvictionPolicy policy = EvictionPolicy::Lru;
+};
+
 class Server {
 public:
     /**
      * @brief Constructs a Server object, initializes the acceptor, configuration manager, and statistics.
      * 
      * This constructor sets up the server to listen for incoming TCP connections on the specified port.
-     * It also loads the server configuration from "config.json" and starts the statistics tracking.
+     * It also loads the server configuration from options.configFile and starts the statistics tracking.
      * 
      * @param io_context Reference to the Boost.Asio I/O context used for asynchronous operations.
-     * @param port The port number on which the server will listen for incoming connections.
+     * @param port The port number on which the server will listen for incoming connections,
+     *        or 0 to let the system pick one (see port()).
+     * @param options Configuration file, value size and memory limits.
      */
-    Server(boost::asio::io_context& io_context, short port);
+    Server(boost::asio::io_context& io_context, short port, const ServerOptions& options = {});
 
     /**
      * @brief Destructor for the Server class.
@@ -39,12 +60,22 @@ public:
      */
     void run();
 
+    /**
+     * @brief Returns the port the server is listening on.
+     *
+     * Useful when the server was constructed with port 0 and the system picked an ephemeral port.
+     *
+     * @return The local port of the acceptor.
+     */
+    unsigned short port() const;
+
 private:
     /**
      * @brief Asynchronously listens for incoming TCP connections and spawns a handler for each client.
      *
      * This coroutine runs an infinite loop, accepting new client connections using the acceptor.
-     * For each accepted connection, it spawns a new coroutine to handle the client using the provided executor.
+     * For each accepted connection, it spawns a new coroutine to handle the client on its own strand,
+     * so sessions run concurrently across the io_context threads.
      * Any exceptions thrown during the accept loop are caught and logged to standard error.
      *
      * @return boost::asio::awaitable<void> An awaitable representing the asynchronous operation.
@@ -59,6 +90,13 @@ private:
      * ("$get <key>" and "$set <key>=<value>"), and sends back compressed responses.
      * The function supports asynchronous I/O using Boost.Asio coroutines.
      *
+     * Every command is a separate zlib stream. Input is inflated incrementally as it
+     * arrives, so a command may span any number of socket reads and several commands
+     * may arrive in one read; the end of a zlib stream marks the end of a command.
+     * Input that is not a valid zlib stream closes the connection, since the next command
+     * boundary cannot be found after it. Every complete command, including an empty one,
+     * gets exactly one response.
+     *
      * Supported commands:
      *   - "$get <key>": Retrieves the value for the specified key from the configuration manager,
      *     increments the read statistics, and returns the value along with read/write counts.
@@ -73,7 +111,21 @@ private:
      */
     boost::asio::awaitable<void> handleClient(boost::asio::ip::tcp::socket socket);
 
+    /**
+     * @brief Executes a single decompressed command and streams the compressed response.
+     *
+     * The response is written in pieces through sendResponse(), so a large value is
+     * compressed and sent chunk by chunk instead of being copied into one response string.
+     *
+     * @param socket The TCP socket representing the client connection.
+     * @param line The decompressed command.
+     * @return boost::asio::awaitable<void> Coroutine handle for asynchronous execution.
+     */
+    boost::asio::awaitable<void> processCommand(boost::asio::ip::tcp::socket& socket, std::string line);
+
+    boost::asio::io_context& ioContext_;
     boost::asio::ip::tcp::acceptor acceptor_;
+    std::size_t maxValueSize_;
     ConfigManager configManager_;
     Stats stats_;
 };
@@ -10,17 +10,25 @@ void Stats::start() {
 }
 
 void Stats::stop() {
-    stopRequested_ = true;
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        stopRequested_ = true;
+    }
+    stopCondition_.notify_all();
     if (printThread_.joinable()) {
         printThread_.join();
     }
 }
 
-void Stats::incrementGet(const std::string& key) {
+void Stats::incrementGet(const std::string& key, bool stored) {
     totalGets_++;
     lastGets_++;
     std::lock_guard<std::mutex> lock(mutex_);
-    keyStats_[key].first++;
+    if (stored) {
+        keyStats_[key].first++;
+    } else {
+        keyStats_.erase(key);
+    }
 }
 
 void Stats::incrementSet(const std::string& key) {
@@ -32,25 +40,48 @@ void Stats::incrementSet(const std::string& key) {
 
 int Stats::getReads(const std::string& key) {
     std::lock_guard<std::mutex> lock(mutex_);
-    return keyStats_[key].first;
+    auto it = keyStats_.find(key);
+    return it != keyStats_.end() ? it->second.first : 0;
 }
 
 int Stats::getWrites(const std::string& key) {
     std::lock_guard<std::mutex> lock(mutex_);
-    return keyStats_[key].second;
+    auto it = keyStats_.find(key);
+    return it != keyStats_.end() ? it->second.second : 0;
 }
 
 std::pair<int, int> Stats::getStats(const std::string& key) {
     std::lock_guard<std::mutex> lock(mutex_);
-    return keyStats_[key];
+    auto it = keyStats_.find(key);
+    return it != keyStats_.end() ? it->second : std::pair<int, int>{};
+}
+
+void Stats::removeKey(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    keyStats_.erase(key);
+}
+
+std::size_t Stats::trackedKeys() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return keyStats_.size();
+}
+
+void Stats::setMemorySource(std::function<MemoryInfo()> source) {
+    memorySource_ = std::move(source);
 }
 
 void Stats::printLoop() {
     using namespace std::chrono_literals;
-    while (!stopRequested_) {
-        std::this_thread::sleep_for(5s);
+    std::unique_lock<std::mutex> lock(stopMutex_);
+    while (!stopCondition_.wait_for(lock, 5s, [this] { return stopRequested_; })) {
         std::cout << "[Stats] Total GETs: " << totalGets_ << ", SETs: " << totalSets_ << "\n";
         std::cout << "[Stats] Last 5s GETs: " << lastGets_ << ", SETs: " << lastSets_ << "\n";
+        if (memorySource_) {
+            MemoryInfo memory = memorySource_();
+            std::cout << "[Stats] Memory used: " << memory.usedMemory << " bytes, maxmemory: " << memory.maxMemory
+                      << ", keys: " << memory.keys << ", evicted: " << memory.evictedKeys
+                      << ", keys with stats: " << trackedKeys() << "\n";
+        }
         lastGets_ = 0;
         lastSets_ = 0;
     }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "MemoryInfo.hpp"
+
 #include <string>
+#include <functional>
 #include <unordered_map>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
 #include <thread>
 
@@ -27,7 +31,7 @@ public:
     /**
      * @brief Stops the statistics tracking thread.
      *
-     * This method sets a flag to request the thread to stop and waits for it to finish.
+     * This method sets a flag to request the thread to stop, wakes it and waits for it to finish.
      */
     void stop();
 
@@ -35,10 +39,13 @@ public:
      * @brief Increments the GET count for a specific key.
      *
      * This method increments the total and last GET counts, and updates the read count for the specified key.
+     * For a key that is not stored only the totals are counted and any counters left for it are dropped,
+     * so requests for missing keys never grow the per-key statistics.
      *
      * @param key The key for which the GET count is being incremented.
+     * @param stored Whether the key was found in the store.
      */
-    void incrementGet(const std::string &key);
+    void incrementGet(const std::string &key, bool stored = true);
 
     /**
      * @brief Increments the SET count for a specific key.
@@ -79,11 +86,34 @@ public:
      */
     std::pair<int, int> getStats(const std::string &key);
 
+    /**
+     * @brief Drops the read and write counts of a key that is no longer stored.
+     *
+     * @param key The key whose statistics are removed.
+     */
+    void removeKey(const std::string &key);
+
+    /**
+     * @brief Returns the number of keys that currently have per-key statistics.
+     */
+    std::size_t trackedKeys();
+
+    /**
+     * @brief Sets the function the background thread calls to obtain memory figures.
+     *
+     * The figures are read when they are printed, so the output is never stale or out of order.
+     * Must be called before start().
+     *
+     * @param source Function returning the current memory figures of the store.
+     */
+    void setMemorySource(std::function<MemoryInfo()> source);
+
 private:
     /**
      * @brief Background thread that prints statistics every 5 seconds.
      *
-     * This method runs in a loop, printing the total and last 5 seconds GET and SET counts.
+     * This method runs in a loop, printing the total and last 5 seconds GET and SET counts
+     * and, if a memory source is set, the current memory figures.
      * The loop continues until stopRequested_ is set to true.
      */
     void printLoop();
@@ -99,7 +129,13 @@ private:
     std::atomic<int> totalSets_;
     std::atomic<int> lastGets_;
     std::atomic<int> lastSets_;
+    std::function<MemoryInfo()> memorySource_;
 
-    std::atomic<bool> stopRequested_ = false;
+    /**
+     * @brief Wakes printLoop() early when stop() is called.
+     */
+    std::mutex stopMutex_;
+    std::condition_variable stopCondition_;
+    bool stopRequested_ = false;
     std::thread printThread_;
 };
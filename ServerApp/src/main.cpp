@@ -4,9 +4,35 @@
 #include <thread>
 #include <vector>
 #include <iostream>
+#include <string>
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        const char* usage = "Usage: ServerApp [--max-value-size <bytes>] [--maxmemory <bytes>] [--maxmemory-policy lru|lfu]\n";
+        ServerOptions options;
+        for (int i = 1; i < argc; i += 2) {
+            std::string option = argv[i];
+            std::string value = i + 1 < argc ? argv[i + 1] : "";
+            try {
+                std::size_t parsed = 0;
+                if (option == "--max-value-size") {
+                    options.maxValueSize = std::stoull(value, &parsed);
+                } else if (option == "--maxmemory") {
+                    options.maxMemory = std::stoull(value, &parsed);
+                } else if (option == "--maxmemory-policy" && (value == "lru" || value == "lfu")) {
+                    options.policy = value == "lfu" ? EvictionPolicy::Lfu : EvictionPolicy::Lru;
+                    parsed = value.size();
+                }
+                if (parsed == 0 || parsed != value.size() || value.starts_with('-')) {
+                    std::cerr << usage;
+                    return 1;
+                }
+            } catch (const std::logic_error&) {
+                std::cerr << usage;
+                return 1;
+            }
+        }
+
         const int thread_count = std::thread::hardware_concurrency();
         boost::asio::io_context io_context;
 
@@ -17,7 +43,7 @@ int main() {
             io_context.stop();
         });
 
-        Server server(io_context, 8888);
+        Server server(io_context, 8888, options);
         server.run();
 
         std::vector<std::thread> threads;
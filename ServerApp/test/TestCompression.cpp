@@ -0,0 +1,102 @@
+#define BOOST_TEST_MODULE CompressionTest
+#include <boost/test/included/unit_test.hpp>
+#include "../src/Compression.hpp"
+
+namespace {
+    std::string makeValue(std::size_t size) {
+        std::string value;
+        value.reserve(size);
+        unsigned int seed = 12345;
+        while (value.size() < size) {
+            seed = seed * 1103515245 + 12345;
+            value.push_back(static_cast<char>('a' + (seed >> 16) % 26));
+        }
+        return value;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compression_round_trip) {
+    const std::string plain = "$set key=" + makeValue(500 * 1024);
+    const std::string compressed = compress_string(plain);
+
+    BOOST_CHECK_EQUAL(decompress_string(compressed, plain.size()), plain);
+    BOOST_CHECK_THROW(decompress_string(compressed, plain.size() - 1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(inflater_streams_across_chunks) {
+    const std::string first = "$set cert=" + makeValue(300 * 1024);
+    const std::string second = "$get cert";
+    const std::string wire = compress_string(first) + compress_string(second);
+
+    Inflater inflater(1024 * 1024);
+    std::vector<std::string> messages;
+
+    // Feed the wire in small, misaligned pieces, as a socket would deliver it.
+    const std::size_t pieceSize = 1000;
+    for (std::size_t pos = 0; pos < wire.size(); pos += pieceSize) {
+        const char* piece = wire.data() + pos;
+        std::size_t size = std::min(pieceSize, wire.size() - pos);
+        std::size_t offset = 0;
+        while (offset < size) {
+            offset += inflater.feed(piece + offset, size - offset);
+            if (!inflater.finished()) break;
+            messages.push_back(inflater.take());
+        }
+    }
+
+    BOOST_REQUIRE_EQUAL(messages.size(), 2u);
+    BOOST_CHECK(messages[0] == first);
+    BOOST_CHECK_EQUAL(messages[1], second);
+}
+
+BOOST_AUTO_TEST_CASE(inflater_drains_oversized_message) {
+    const std::string wire = compress_string(makeValue(64 * 1024)) + compress_string("$get key");
+
+    Inflater inflater(1024);
+    std::size_t consumed = inflater.feed(wire.data(), wire.size());
+    BOOST_REQUIRE(inflater.finished());
+    BOOST_CHECK(inflater.overflowed());
+    BOOST_CHECK(inflater.take().empty());
+
+    inflater.feed(wire.data() + consumed, wire.size() - consumed);
+    BOOST_REQUIRE(inflater.finished());
+    BOOST_CHECK(!inflater.overflowed());
+    BOOST_CHECK_EQUAL(inflater.take(), "$get key");
+}
+
+BOOST_AUTO_TEST_CASE(deflater_streams_pieces) {
+    const std::string value = makeValue(200 * 1024);
+
+    Deflater deflater;
+    std::string wire;
+    deflater.feed("key=");
+    deflater.feed(value);
+    wire += deflater.takeOutput();
+    deflater.feed("\n");
+    deflater.finish();
+    wire += deflater.takeOutput();
+
+    // The deflater is reusable for the next message.
+    deflater.feed("next");
+    deflater.finish();
+    const std::string next = deflater.takeOutput();
+
+    BOOST_CHECK(decompress_string(wire, 1024 * 1024) == "key=" + value + "\n");
+    BOOST_CHECK_EQUAL(decompress_string(next, 1024), "next");
+}
+
+BOOST_AUTO_TEST_CASE(deflater_compact_window) {
+    const std::string value = makeValue(100 * 1024);
+
+    Deflater deflater(Z_BEST_COMPRESSION, 12, 4);
+    deflater.feed(value);
+    deflater.finish();
+
+    BOOST_CHECK(decompress_string(deflater.takeOutput(), value.size()) == value);
+}
+
+BOOST_AUTO_TEST_CASE(inflater_rejects_garbage) {
+    const std::string garbage = "not a zlib stream";
+    Inflater inflater(1024);
+    BOOST_CHECK_THROW(inflater.feed(garbage.data(), garbage.size()), std::runtime_error);
+}
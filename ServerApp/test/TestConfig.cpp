@@ -2,6 +2,8 @@
 #include <boost/test/included/unit_test.hpp>
 #include "../src/ConfigManager.hpp"
 #include <filesystem>
+#include <thread>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -27,3 +29,178 @@ BOOST_AUTO_TEST_CASE(config_get_set) {
 
     fs::remove(testFile);
 }
+
+BOOST_AUTO_TEST_CASE(config_memory_accounting) {
+    const std::string testFile = "config_memory_test.json";
+    fs::remove(testFile);
+
+    ConfigManager config(testFile);
+    config.load();
+
+    MemoryInfo empty = config.memoryInfo();
+    BOOST_CHECK_EQUAL(empty.keys, 0u);
+    BOOST_CHECK_EQUAL(empty.maxMemory, 0u);
+
+    const std::string big(100000, 'x');
+    config.set("big", big);
+    MemoryInfo one = config.memoryInfo();
+    BOOST_CHECK_EQUAL(one.keys, 1u);
+    BOOST_CHECK_GE(one.usedMemory - empty.usedMemory, big.size());
+
+    // Overwriting with a short value releases the large buffer.
+    config.set("big", "small");
+    BOOST_CHECK_LE(config.memoryInfo().usedMemory + big.size(), one.usedMemory);
+
+    fs::remove(testFile);
+}
+
+BOOST_AUTO_TEST_CASE(config_lru_eviction) {
+    const std::string testFile = "config_lru_test.json";
+    fs::remove(testFile);
+
+    const std::size_t maxMemory = 64 * 1024;
+    ConfigManager config(testFile, maxMemory, EvictionPolicy::Lru);
+    config.load();
+    std::vector<std::string> evicted;
+    config.setEvictionCallback([&](const std::string& key) { evicted.push_back(key); });
+
+    const std::string value(1000, 'v');
+    for (int i = 0; i < 500; ++i) {
+        BOOST_REQUIRE(config.set("key" + std::to_string(i), value));
+    }
+
+    MemoryInfo memory = config.memoryInfo();
+    BOOST_CHECK_LE(memory.usedMemory, maxMemory);
+    BOOST_CHECK_GT(memory.evictedKeys, 0u);
+    BOOST_CHECK_EQUAL(memory.keys + memory.evictedKeys, 500u);
+
+    // Every evicted key is reported once and is gone from the store.
+    BOOST_REQUIRE_EQUAL(evicted.size(), memory.evictedKeys);
+    for (const auto& key : evicted) {
+        BOOST_CHECK(!config.find(key));
+    }
+
+    // The most recently written key is never the one evicted.
+    BOOST_CHECK_EQUAL(config.get("key499"), value);
+
+    // An entry that cannot fit next to the bucket array is rejected without evicting anything.
+    for (std::size_t size : {maxMemory, maxMemory - 100}) {
+        BOOST_CHECK(!config.set("huge", std::string(size, 'h')));
+        BOOST_CHECK_EQUAL(config.get("huge"), "");
+        BOOST_CHECK_EQUAL(config.memoryInfo().keys, memory.keys);
+    }
+
+    fs::remove(testFile);
+}
+
+BOOST_AUTO_TEST_CASE(config_admission_boundary) {
+    const std::string testFile = "config_admission_test.json";
+    fs::remove(testFile);
+
+    const std::size_t maxMemory = 64 * 1024;
+    const std::string value(1000, 'v');
+    const int keys = 50;
+
+    // Around the limit the bucket array and the sample index decide whether a value fits. Every
+    // size must either be stored within the limit or be rejected with the cache left untouched.
+    bool accepted = false;
+    bool rejected = false;
+    for (std::size_t size = maxMemory - 4096; size <= maxMemory; size += 4) {
+        for (const std::string key : {"huge", "key7"}) {
+            ConfigManager config(testFile, maxMemory, EvictionPolicy::Lru);
+            for (int i = 0; i < keys; ++i) {
+                config.set("key" + std::to_string(i), value);
+            }
+            BOOST_REQUIRE_EQUAL(config.memoryInfo().evictedKeys, 0u);
+
+            const std::string big(size, 'h');
+            if (config.set(key, big)) {
+                accepted = true;
+                BOOST_CHECK_LE(config.memoryInfo().usedMemory, maxMemory);
+                BOOST_CHECK(config.get(key) == big);
+            } else {
+                rejected = true;
+                MemoryInfo memory = config.memoryInfo();
+                BOOST_CHECK_EQUAL(memory.keys, static_cast<std::size_t>(keys));
+                BOOST_CHECK_EQUAL(memory.evictedKeys, 0u);
+                BOOST_CHECK_EQUAL(config.get("key7"), value);
+            }
+        }
+    }
+    BOOST_CHECK(accepted);
+    BOOST_CHECK(rejected);
+
+    fs::remove(testFile);
+}
+
+BOOST_AUTO_TEST_CASE(config_lru_keeps_recently_read_keys) {
+    const std::string testFile = "config_lru_order_test.json";
+    fs::remove(testFile);
+
+    const std::string value(200, 'v');
+    const int keys = 1000;
+
+    // Size the limit so that exactly the first batch fits.
+    std::size_t maxMemory = 0;
+    {
+        ConfigManager probe(testFile + ".probe");
+        for (int i = 0; i < keys; ++i) {
+            probe.set("key" + std::to_string(i), value);
+        }
+        maxMemory = probe.memoryInfo().usedMemory;
+    }
+
+    ConfigManager config(testFile, maxMemory, EvictionPolicy::Lru);
+    config.load();
+    for (int i = 0; i < keys; ++i) {
+        config.set("key" + std::to_string(i), value);
+    }
+    BOOST_REQUIRE_EQUAL(config.memoryInfo().evictedKeys, 0u);
+
+    // The LRU clock has millisecond resolution; keep the phases apart.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (int i = keys / 2; i < keys; ++i) {
+        config.get("key" + std::to_string(i));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (int i = 0; i < keys / 2; ++i) {
+        config.set("new" + std::to_string(i), value);
+    }
+
+    int unreadSurvivors = 0;
+    int readSurvivors = 0;
+    for (int i = 0; i < keys; ++i) {
+        if (!config.get("key" + std::to_string(i)).empty()) {
+            (i < keys / 2 ? unreadSurvivors : readSurvivors)++;
+        }
+    }
+    BOOST_TEST_MESSAGE("unread survivors: " << unreadSurvivors << ", read survivors: " << readSurvivors);
+    BOOST_CHECK_GT(config.memoryInfo().evictedKeys, static_cast<std::size_t>(keys / 4));
+    BOOST_CHECK_GE(readSurvivors, keys / 2 * 85 / 100);
+    BOOST_CHECK_LE(unreadSurvivors, keys / 2 * 15 / 100);
+
+    fs::remove(testFile);
+}
+
+BOOST_AUTO_TEST_CASE(config_lfu_keeps_hot_key) {
+    const std::string testFile = "config_lfu_test.json";
+    fs::remove(testFile);
+
+    const std::size_t maxMemory = 64 * 1024;
+    ConfigManager config(testFile, maxMemory, EvictionPolicy::Lfu);
+    config.load();
+
+    const std::string value(1000, 'v');
+    config.set("hot", value);
+    for (int i = 0; i < 1000; ++i) {
+        config.get("hot");
+    }
+    for (int i = 0; i < 500; ++i) {
+        config.set("key" + std::to_string(i), value);
+    }
+
+    BOOST_CHECK_LE(config.memoryInfo().usedMemory, maxMemory);
+    BOOST_CHECK_EQUAL(config.get("hot"), value);
+
+    fs::remove(testFile);
+}
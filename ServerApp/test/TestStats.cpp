@@ -17,3 +17,25 @@ BOOST_AUTO_TEST_CASE(stats_counting) {
     BOOST_CHECK_EQUAL(stats.getReads("banana"), 1);
     BOOST_CHECK_EQUAL(stats.getWrites("banana"), 0);
 }
+
+BOOST_AUTO_TEST_CASE(stats_forget_missing_keys) {
+    Stats stats;
+
+    // Reads of keys that are not stored are counted in the totals only.
+    for (int i = 0; i < 100; ++i) {
+        stats.incrementGet("missing" + std::to_string(i), false);
+    }
+    BOOST_CHECK_EQUAL(stats.getReads("missing0"), 0);
+    BOOST_CHECK_EQUAL(stats.trackedKeys(), 0u);
+
+    stats.incrementGet("apple");
+    stats.incrementSet("banana");
+    BOOST_CHECK_EQUAL(stats.trackedKeys(), 2u);
+
+    // An evicted key loses its counters, and so does a key that turns out to be missing.
+    stats.removeKey("apple");
+    stats.incrementGet("banana", false);
+    BOOST_CHECK_EQUAL(stats.getReads("apple"), 0);
+    BOOST_CHECK_EQUAL(stats.getWrites("banana"), 0);
+    BOOST_CHECK_EQUAL(stats.trackedKeys(), 0u);
+}
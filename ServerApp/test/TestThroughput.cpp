@@ -0,0 +1,264 @@
+#define BOOST_TEST_MODULE ThroughputTest
+#include <boost/test/included/unit_test.hpp>
+#include "../src/Server.hpp"
+#include "../src/Compression.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+namespace fs = std::filesystem;
+
+namespace {
+    /**
+     * @brief Load parameters and reference results, read from throughput_baseline.json.
+     */
+    struct Baseline {
+        int connections;
+        double durationSeconds;
+        double throughputRps;
+        double throughputTolerance;
+        double p99Micros;
+        double p99Tolerance;
+        std::size_t scalingPayloadBytes;
+        double scalingDurationSeconds;
+        double minScalingEfficiency;
+    };
+
+    Baseline loadBaseline() {
+        std::ifstream file(THROUGHPUT_BASELINE_FILE);
+        BOOST_REQUIRE_MESSAGE(file.is_open(), "Cannot open baseline " << THROUGHPUT_BASELINE_FILE);
+        nlohmann::json data;
+        file >> data;
+        return Baseline{
+            data.at("connections").get<int>(),
+            data.at("duration_seconds").get<double>(),
+            data.at("throughput_rps").get<double>(),
+            data.at("throughput_tolerance").get<double>(),
+            data.at("p99_us").get<double>(),
+            data.at("p99_tolerance").get<double>(),
+            data.at("scaling_payload_bytes").get<std::size_t>(),
+            data.at("scaling_duration_seconds").get<double>(),
+            data.at("min_scaling_efficiency").get<double>(),
+        };
+    }
+
+    std::string makeValue(std::size_t size, unsigned int seed) {
+        std::minstd_rand rng(seed);
+        std::string value(size, 'a');
+        for (char& c : value) {
+            c = static_cast<char>('a' + rng() % 26);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Runs a Server in-process on an ephemeral port with a temporary config file.
+     */
+    class ServerUnderTest {
+    public:
+        explicit ServerUnderTest(const nlohmann::json& initialConfig) {
+            configFile_ = fs::temp_directory_path() /
+                ("ServerApp_throughput_" + std::to_string(std::random_device{}()) + ".json");
+            std::ofstream(configFile_) << initialConfig.dump();
+
+            ServerOptions options;
+            options.configFile = configFile_.string();
+            server_ = std::make_unique<Server>(io_context_, 0, options);
+            server_->run();
+
+            const unsigned int thread_count = std::max(2u, std::thread::hardware_concurrency());
+            for (unsigned int i = 0; i < thread_count; ++i) {
+                threads_.emplace_back([this]() {
+                    io_context_.run();
+                });
+            }
+        }
+
+        ~ServerUnderTest() {
+            io_context_.stop();
+            for (auto& t : threads_) {
+                t.join();
+            }
+            server_.reset();
+            fs::remove(configFile_);
+        }
+
+        unsigned short port() const { return server_->port(); }
+
+    private:
+        fs::path configFile_;
+        boost::asio::io_context io_context_;
+        std::unique_ptr<Server> server_;
+        std::vector<std::thread> threads_;
+    };
+
+    using Workload = std::function<std::string(std::minstd_rand&)>;
+
+    /**
+     * @brief Latencies of all requests of one load run, sorted, in microseconds.
+     */
+    struct LoadResult {
+        std::vector<double> latencies;
+        double seconds;
+
+        double throughput() const { return latencies.size() / seconds; }
+
+        double percentile(double fraction) const {
+            std::size_t index = static_cast<std::size_t>(fraction * latencies.size());
+            return latencies[std::min(index, latencies.size() - 1)];
+        }
+    };
+
+    /**
+     * @brief Drives one connection with the given workload until the deadline.
+     *
+     * Each request waits for its complete response before the next one is sent; the latency of
+     * every round trip is appended to latencies in microseconds.
+     */
+    void runClient(unsigned short port, Clock::time_point deadline, unsigned int seed,
+                   const Workload& workload, std::vector<double>& latencies) {
+        boost::asio::io_context io_context;
+        tcp::socket socket(io_context);
+        socket.connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+        socket.set_option(tcp::no_delay(true));
+
+        std::minstd_rand rng(seed);
+        Inflater inflater(16 * 1024 * 1024);
+        std::array<char, kCompressionChunkSize> data;
+
+        while (Clock::now() < deadline) {
+            std::string compressed = compress_string(workload(rng));
+
+            auto start = Clock::now();
+            boost::asio::write(socket, boost::asio::buffer(compressed));
+            while (!inflater.finished()) {
+                std::size_t n = socket.read_some(boost::asio::buffer(data));
+                inflater.feed(data.data(), n);
+            }
+            auto end = Clock::now();
+
+            inflater.take();
+            latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+    }
+
+    /**
+     * @brief Runs the workload over the given number of connections for a fixed duration.
+     *
+     * Client failures are collected per thread and reported from the calling thread, since
+     * Boost.Test logging is not thread-safe.
+     */
+    LoadResult runLoad(unsigned short port, int connections, double seconds, const Workload& workload) {
+        const auto duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        const auto deadline = Clock::now() + duration;
+
+        std::vector<std::vector<double>> latencies(connections);
+        std::vector<std::string> errors(connections);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < connections; ++i) {
+            clients.emplace_back([&, i]() {
+                try {
+                    runClient(port, deadline, i + 1, workload, latencies[i]);
+                } catch (const std::exception& e) {
+                    errors[i] = e.what();
+                }
+            });
+        }
+        for (auto& t : clients) {
+            t.join();
+        }
+
+        for (int i = 0; i < connections; ++i) {
+            BOOST_CHECK_MESSAGE(errors[i].empty(), "Client " << i << " failed: " << errors[i]);
+        }
+
+        LoadResult result{{}, seconds};
+        for (const auto& clientLatencies : latencies) {
+            result.latencies.insert(result.latencies.end(), clientLatencies.begin(), clientLatencies.end());
+        }
+        BOOST_REQUIRE(!result.latencies.empty());
+        std::sort(result.latencies.begin(), result.latencies.end());
+        return result;
+    }
+
+    /**
+     * @brief Appends one result row to throughput_results.csv so runs can be charted over time.
+     */
+    void appendResults(const std::string& scenario, int connections, const LoadResult& result) {
+        const std::string fileName = "throughput_results.csv";
+        bool writeHeader = !fs::exists(fileName);
+        std::ofstream file(fileName, std::ios::app);
+        if (writeHeader) {
+            file << "timestamp,scenario,connections,duration_s,requests,throughput_rps,p50_us,p99_us,max_us\n";
+        }
+        auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        file << timestamp << ',' << scenario << ',' << connections << ',' << result.seconds << ','
+             << result.latencies.size() << ',' << result.throughput() << ',' << result.percentile(0.50) << ','
+             << result.percentile(0.99) << ',' << result.latencies.back() << '\n';
+
+        std::cout << "[Throughput] scenario=" << scenario
+                  << " connections=" << connections
+                  << " requests=" << result.latencies.size()
+                  << " throughput_rps=" << result.throughput()
+                  << " p50_us=" << result.percentile(0.50)
+                  << " p99_us=" << result.percentile(0.99)
+                  << " max_us=" << result.latencies.back() << "\n";
+    }
+}
+
+BOOST_AUTO_TEST_CASE(throughput_against_baseline) {
+    const Baseline baseline = loadBaseline();
+    ServerUnderTest server(nlohmann::json::object());
+
+    // The client.py workload: 99% $get, 1% $set over a handful of keys.
+    const Workload mixed = [](std::minstd_rand& rng) {
+        static const std::array<std::string, 5> keys{"tree", "sky", "grass", "cloud", "flower"};
+        const std::string& key = keys[rng() % keys.size()];
+        return rng() % 100 == 0
+            ? "$set " + key + "=" + std::to_string(rng() % 100 + 1)
+            : "$get " + key;
+    };
+    LoadResult result = runLoad(server.port(), baseline.connections, baseline.durationSeconds, mixed);
+    appendResults("mixed", baseline.connections, result);
+
+    const double minThroughput = baseline.throughputRps * (1.0 - baseline.throughputTolerance);
+    const double maxP99 = baseline.p99Micros * (1.0 + baseline.p99Tolerance);
+    BOOST_CHECK_GE(result.throughput(), minThroughput);
+    BOOST_CHECK_LE(result.percentile(0.99), maxP99);
+}
+
+BOOST_AUTO_TEST_CASE(throughput_scales_with_connections) {
+    const Baseline baseline = loadBaseline();
+    const unsigned int cores = std::thread::hardware_concurrency();
+    if (cores < 2) {
+        BOOST_TEST_MESSAGE("Skipping scaling check: needs at least 2 hardware threads, found " << cores);
+        return;
+    }
+
+    // Compressing a large value dominates the cost of a request, so a server that serializes
+    // sessions stays at single-connection throughput no matter how many clients it serves.
+    ServerUnderTest server(nlohmann::json{{"payload", makeValue(baseline.scalingPayloadBytes, 42)}});
+    const Workload payload = [](std::minstd_rand&) { return std::string("$get payload"); };
+
+    const int connections = static_cast<int>(std::min<unsigned int>(cores, baseline.connections));
+    LoadResult single = runLoad(server.port(), 1, baseline.scalingDurationSeconds, payload);
+    LoadResult parallel = runLoad(server.port(), connections, baseline.scalingDurationSeconds, payload);
+    appendResults("payload", 1, single);
+    appendResults("payload", connections, parallel);
+
+    const double speedup = parallel.throughput() / single.throughput();
+    const double minSpeedup = 1.0 + baseline.minScalingEfficiency * (connections - 1);
+    BOOST_TEST_MESSAGE("Speedup with " << connections << " connections: " << speedup << ", required " << minSpeedup);
+    BOOST_CHECK_GE(speedup, minSpeedup);
+}